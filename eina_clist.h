@@ -308,6 +308,162 @@ static inline void eina_clist_move_tail(Eina_Clist *dst, Eina_Clist *src);
  */
 static inline void eina_clist_move_head(Eina_Clist *dst, Eina_Clist *src);
 
+/**
+ * @typedef Eina_Clist_Compare_Cb
+ * @brief Type for a callback comparing two list entries.
+ *
+ * The callback gets the list entries, and uses EINA_CLIST_ENTRY to get the
+ * structures containing them:
+ *
+ * @code
+ *   static int
+ *   gadget_cmp(const Eina_Clist *a, const Eina_Clist *b)
+ *   {
+ *       const struct gadget *ga = EINA_CLIST_ENTRY(a, struct gadget, entry);
+ *       const struct gadget *gb = EINA_CLIST_ENTRY(b, struct gadget, entry);
+ *       return ga->a - gb->a;
+ *   }
+ * @endcode
+ *
+ * @return A negative value if @p a comes before @p b, a positive one if it
+ *         comes after it, and zero if they are equal.
+ *
+ * @since 1.21
+ */
+typedef int (*Eina_Clist_Compare_Cb)(const Eina_Clist *a, const Eina_Clist *b);
+
+/**
+ * @brief Sorts a list.
+ *
+ * @param[in,out] list The list.
+ * @param[in] cmp The function used to compare two elements.
+ *
+ * @details This is a bottom-up merge sort, done in place: it takes O(N log N)
+ *          time, does not allocate any memory, and only relinks the elements.
+ *          The sort is stable, so equal elements keep their relative order.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_sort(Eina_Clist *list, Eina_Clist_Compare_Cb cmp);
+
+/**
+ * @brief Merges a sorted list into another one.
+ *
+ * @param[in,out] dst The sorted list to merge into.
+ * @param[in,out] src The sorted list to merge.
+ * @param[in] cmp The function used to compare two elements.
+ * @pre Both @p dst and @p src are sorted according to @p cmp.
+ * @post @p dst is sorted and @p src is initialized, but is empty after this operation.
+ *
+ * @details This takes O(N) time. Elements of @p dst come before equal elements
+ *          of @p src.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_merge_sorted(Eina_Clist *dst, Eina_Clist *src, Eina_Clist_Compare_Cb cmp);
+
+/**
+ * @brief Splits a list in two at the given element.
+ *
+ * @param[in,out] list The list.
+ * @param[in] elem An element of @p list, the first one to move.
+ * @param[out] dst The list that receives @p elem and all the elements after it.
+ * @pre @p elem is in @p list.
+ * @post @p dst is initialized, so any element it held is lost.
+ *
+ * @details This takes O(1) time.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_split_at(Eina_Clist *list, Eina_Clist *elem, Eina_Clist *dst);
+
+/**
+ * @typedef Eina_Clist_Mpsc
+ * @brief Type for #_Eina_Clist_Mpsc structure, a lock-free queue of list entries.
+ * @since 1.21
+ */
+typedef struct _Eina_Clist_Mpsc Eina_Clist_Mpsc;
+
+/**
+ * @struct _Eina_Clist_Mpsc
+ * @brief The structure type for a lock-free multi-producer, single-consumer queue.
+ *
+ * Elements are the same #Eina_Clist entries that are used in regular lists, so
+ * a structure does not need a second link field to be handed over from
+ * other threads. Any thread may add elements with eina_clist_mpsc_push(), but
+ * only one thread may take them with eina_clist_mpsc_take_all().
+ *
+ * @note This structure must be initialized with EINA_CLIST_MPSC_INIT, or by
+ *       calling eina_clist_mpsc_init().
+ *
+ * @since 1.21
+ */
+struct _Eina_Clist_Mpsc
+{
+   Eina_Clist *last; /**< The last element pushed, or @c NULL if the queue is empty */
+};
+
+/**
+ * @brief Initializes a lock-free queue.
+ *
+ * @param[in,out] queue The queue.
+ * @post The queue contains no items.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_mpsc_init(Eina_Clist_Mpsc *queue);
+
+/**
+ * @brief Adds an element to a lock-free queue.
+ *
+ * @param[in,out] queue The queue.
+ * @param[in] elem An element.
+ * @pre The element is not in any list or queue.
+ *
+ * @note This function may be called from any thread at the same time. It
+ *       never blocks and is lock-free, but it is not wait-free: under
+ *       contention, its atomic compare-and-swap on the queue is retried until
+ *       it succeeds.
+ * @note Only the @c next pointer of @p elem is used while it is in the queue.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_mpsc_push(Eina_Clist_Mpsc *queue, Eina_Clist *elem);
+
+/**
+ * @brief Moves all the elements of a lock-free queue to the tail of a list.
+ *
+ * @param[in,out] queue The queue.
+ * @param[in,out] dst The list to be appended.
+ *
+ * @details The elements are appended to @p dst in the order they were pushed,
+ *          like eina_clist_move_tail() would do with a regular list. Elements
+ *          pushed while this function runs are either moved, or kept for the
+ *          next call.
+ *
+ *          Unlike eina_clist_move_tail(), this takes O(N) time, as the elements
+ *          are detached in the reverse order they were pushed and have to be
+ *          relinked one by one.
+ *
+ * @note Only one thread at a time may call this function on a given queue.
+ *
+ * @since 1.21
+ */
+static inline void eina_clist_mpsc_take_all(Eina_Clist_Mpsc *queue, Eina_Clist *dst);
+
+/**
+ * @brief Checks whether a lock-free queue is empty.
+ *
+ * @param[in] queue The queue.
+ * @return A non-zero value if @p queue is empty. Otherwise, zero if it is not.
+ *
+ * @note The result may already be outdated when this function returns if other
+ *       threads push elements.
+ *
+ * @since 1.21
+ */
+static inline int eina_clist_mpsc_empty(const Eina_Clist_Mpsc *queue);
+
 /**
  * @def EINA_CLIST_FOR_EACH
  * @brief Iterates through the list.
@@ -417,6 +573,62 @@ static inline void eina_clist_move_head(Eina_Clist *dst, Eina_Clist *src);
          (cursor) = (cursor2), \
          (cursor2) = EINA_CLIST_ENTRY((cursor)->field.prev, type, field))
 
+/**
+ * @def EINA_CLIST_PREFETCH
+ * @brief Hints the processor to fetch the memory at the given address.
+ *
+ * @param[in] addr The address to prefetch. It does not need to be valid.
+ *
+ * @since 1.21
+ */
+#undef EINA_CLIST_PREFETCH
+#if defined(__GNUC__)
+# define EINA_CLIST_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+# define EINA_CLIST_PREFETCH(addr) ((void)(addr))
+#endif
+
+/**
+ * @def EINA_CLIST_FOR_EACH_PREFETCH
+ * @brief Iterates through the list while prefetching the upcoming elements.
+ *
+ * This is the same as EINA_CLIST_FOR_EACH, but at each step, the element after
+ * the next one is prefetched, so walking a long list does not wait on
+ * each pointer load.
+ *
+ * @param[out] cursor The pointer to be used during the interaction.
+ * @param[in] list The list to be interacted with.
+ *
+ * @since 1.21
+ */
+#define EINA_CLIST_FOR_EACH_PREFETCH(cursor,list) \
+    for ((cursor) = (list)->next; \
+         (cursor) != (list) && \
+         (EINA_CLIST_PREFETCH((cursor)->next->next), 1); \
+         (cursor) = (cursor)->next)
+
+/**
+ * @def EINA_CLIST_FOR_EACH_ENTRY_PREFETCH
+ * @brief Iterates through the list using a list entry while prefetching the upcoming elements.
+ *
+ * This is the same as EINA_CLIST_FOR_EACH_ENTRY, but at each step, the element
+ * after the next one and the structure containing the next one are prefetched.
+ * It is worth it on long lists whose elements are used in the loop body.
+ *
+ * @param[out] elem The element to be used.
+ * @param[in] list The list to be iterated.
+ * @param[in] type The type of the list.
+ * @param[in] field The field of the element.
+ *
+ * @since 1.21
+ */
+#define EINA_CLIST_FOR_EACH_ENTRY_PREFETCH(elem, list, type, field) \
+    for ((elem) = EINA_CLIST_ENTRY((list)->next, type, field); \
+         &(elem)->field != (list) && \
+         (EINA_CLIST_PREFETCH((elem)->field.next->next), \
+          EINA_CLIST_PREFETCH(EINA_CLIST_ENTRY((elem)->field.next, type, field)), 1); \
+         (elem) = EINA_CLIST_ENTRY((elem)->field.next, type, field))
+
 /**
  * @def EINA_CLIST_INIT
  * @brief Macros for statically initialized lists.
@@ -426,6 +638,15 @@ static inline void eina_clist_move_head(Eina_Clist *dst, Eina_Clist *src);
 #undef EINA_CLIST_INIT
 #define EINA_CLIST_INIT(list)  { &(list), &(list) }
 
+/**
+ * @def EINA_CLIST_MPSC_INIT
+ * @brief Macros for statically initialized lock-free queues.
+ *
+ * @since 1.21
+ */
+#undef EINA_CLIST_MPSC_INIT
+#define EINA_CLIST_MPSC_INIT  { 0 }
+
 /**
  * @def EINA_CLIST_ENTRY
  * @brief Gets a pointer to the object containing the list element.
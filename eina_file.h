@@ -29,6 +29,7 @@
 #include "eina_iterator.h"
 #include "eina_tmpstr.h"
 #include "eina_str.h"
+#include "eina_slice.h"
 
 /**
  * @page eina_file_example_01_page
@@ -102,6 +103,20 @@ typedef struct _Eina_Stat Eina_Stat;
  */
 typedef struct _Eina_File_Line Eina_File_Line;
 
+/**
+ * @typedef Eina_File_Dir_Entry
+ * @brief A type for #_Eina_File_Dir_Entry.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Dir_Entry Eina_File_Dir_Entry;
+
+/**
+ * @typedef Eina_File_Dir_Batch
+ * @brief A type for #_Eina_File_Dir_Batch.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Dir_Batch Eina_File_Dir_Batch;
+
 /**
  * @typedef Eina_File_Dir_List_Cb
  * @brief Type for a callback to be called when iterating the files of a
@@ -112,6 +127,20 @@ typedef struct _Eina_File_Line Eina_File_Line;
  */
 typedef void (*Eina_File_Dir_List_Cb)(const char *name, const char *path, void *data);
 
+/**
+ * @typedef Eina_File_Walk_Cb
+ * @brief Type for a callback to be called for every file found by
+ *        eina_file_walk_parallel().
+ * @param[in] data The data passed to eina_file_walk_parallel()
+ * @param[in] dirfd A file descriptor of the directory containing the file,
+ *                  usable with fstatat() or openat() during the call
+ * @param[in] info The information of the file, only valid during the call
+ * @return For directories, #EINA_FALSE to skip their content. It is
+ *         ignored for other files.
+ * @since 1.21
+ */
+typedef Eina_Bool (*Eina_File_Walk_Cb)(void *data, int dirfd, const Eina_File_Direct_Info *info);
+
 /**
  * @typedef Eina_File_Type
  * @brief Type for enumeration of a file type.
@@ -135,6 +164,53 @@ typedef enum {
  */
 typedef struct _Eina_File Eina_File;
 
+/**
+ * @typedef Eina_File_Map_Window
+ * @brief A sliding window over the mapped content of an #Eina_File.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Map_Window Eina_File_Map_Window;
+
+/**
+ * @typedef Eina_File_Prefetch
+ * @brief A queue of file ranges to read ahead of their use.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Prefetch Eina_File_Prefetch;
+
+/**
+ * @typedef Eina_File_Pack
+ * @brief A set of virtual files sharing the same memory.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Pack Eina_File_Pack;
+
+/**
+ * @typedef Eina_File_Pack_Member
+ * @brief A type for #_Eina_File_Pack_Member.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Pack_Member Eina_File_Pack_Member;
+
+/**
+ * @typedef Eina_File_Xattr_Batch
+ * @brief A reusable buffer to fetch a fixed set of extended attributes.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Xattr_Batch Eina_File_Xattr_Batch;
+
+/**
+ * @struct _Eina_File_Pack_Member
+ * @brief The structure to describe one file of an #Eina_File_Pack.
+ * @since 1.21
+ */
+struct _Eina_File_Pack_Member
+{
+   const char         *name;   /**< The virtual name of the file */
+   unsigned long long  offset; /**< The offset of its content in the pack */
+   unsigned long long  length; /**< The length of its content */
+};
+
 /**
  * @typedef Eina_File_Populate
  * @brief Type for enumeration of a file access type.
@@ -146,9 +222,45 @@ typedef enum {
   EINA_FILE_WILLNEED,   /**< Advises need for all the mapped memory */
   EINA_FILE_POPULATE,   /**< Requests for all the mapped memory */
   EINA_FILE_DONTNEED,   /**< Indicates that the memory is no longer needed. This may result in the memory being removed from any caches if applicable. @since 1.8 */
-  EINA_FILE_REMOVE      /**< This memory is to be released. Any content within will be lost. Subsequent accesses will succeed, but they will return fresh memory as if accessed for the first time. This may not succeed if it is not supported by the filesystem. @since 1.8 */
+  EINA_FILE_REMOVE,     /**< This memory is to be released. Any content within will be lost. Subsequent accesses will succeed, but they will return fresh memory as if accessed for the first time. This may not succeed if it is not supported by the filesystem. @since 1.8 */
+  EINA_FILE_HUGEPAGE,   /**< Advises to back the mapped memory with huge pages, if the system and the filesystem support it. The mapping is aligned so that as much of it as possible can use huge pages. @since 1.21 */
+  EINA_FILE_LOCK        /**< Requests for all the mapped memory and locks it in RAM, so it is never paged out. The lock is released when the map is freed, or when #EINA_FILE_DONTNEED or #EINA_FILE_REMOVE is applied to it. This may fail silently if the lock limit of the process is reached. @since 1.21 */
 } Eina_File_Populate;
 
+/**
+ * @typedef Eina_Stat_Mask
+ * @brief Type for a mask of the #Eina_Stat fields to fetch.
+ * @details This type is used by eina_file_statat_mask() and
+ *          eina_file_statat_batch(). It mirrors the mask of statx().
+ * @since 1.21
+ */
+typedef enum {
+  EINA_STAT_MASK_TYPE   = (1 << 0),  /**< The file type part of @c mode */
+  EINA_STAT_MASK_MODE   = (1 << 1),  /**< The permission part of @c mode */
+  EINA_STAT_MASK_NLINK  = (1 << 2),  /**< @c nlink */
+  EINA_STAT_MASK_UID    = (1 << 3),  /**< @c uid */
+  EINA_STAT_MASK_GID    = (1 << 4),  /**< @c gid */
+  EINA_STAT_MASK_ATIME  = (1 << 5),  /**< @c atime and @c atimensec */
+  EINA_STAT_MASK_MTIME  = (1 << 6),  /**< @c mtime and @c mtimensec */
+  EINA_STAT_MASK_CTIME  = (1 << 7),  /**< @c ctime and @c ctimensec */
+  EINA_STAT_MASK_INO    = (1 << 8),  /**< @c dev, @c ino and @c rdev */
+  EINA_STAT_MASK_SIZE   = (1 << 9),  /**< @c size and @c blksize */
+  EINA_STAT_MASK_BLOCKS = (1 << 10), /**< @c blocks */
+  EINA_STAT_MASK_ALL    = 0x7ff      /**< All the fields, like eina_file_statat() */
+} Eina_Stat_Mask;
+
+/**
+ * @typedef Eina_File_Write_Flags
+ * @brief Enumeration for a flag, and how to open a file for writing.
+ * @details This type is used by eina_file_open_rw().
+ * @since 1.21
+ */
+typedef enum {
+  EINA_FILE_WRITE_DEFAULT  = 0,        /**< Opens the file in place, keeping its content */
+  EINA_FILE_WRITE_TRUNCATE = (1 << 0), /**< Drops the previous content of the file */
+  EINA_FILE_WRITE_ATOMIC   = (1 << 1)  /**< Writes to a temporary file next to the target, which only replaces it on eina_file_publish(). Implies #EINA_FILE_WRITE_TRUNCATE */
+} Eina_File_Write_Flags;
+
 /* Why do this? When the app using eina is compiled, PATH_MAX may vary 
 * from eina when eina is compiled. The path buffer below cannot safely, 
 * and portably, vary when exposed, depending on how and when you compile.
@@ -237,6 +349,45 @@ struct _Eina_File_Line
   unsigned long long length; /**< The number of characters in the line */
 };
 
+/**
+ * @struct _Eina_File_Dir_Entry
+ * @brief The structure to store compact information of a path.
+ * @details Unlike #Eina_File_Direct_Info, the path is not stored in the
+ *          structure but in the arena of the #Eina_File_Dir_Batch it
+ *          belongs to.
+ * @since 1.21
+ */
+struct _Eina_File_Dir_Entry
+{
+   unsigned int         path_offset;  /**< Start position of the path in the arena */
+   unsigned int         path_length;  /**< Size of the whole path */
+   unsigned int         name_start;   /**< Start position of the filename/basename component in the path */
+   unsigned int         name_length;  /**< Size of the filename/basename component */
+   Eina_File_Type       type;         /**< File type */
+};
+
+/**
+ * @struct _Eina_File_Dir_Batch
+ * @brief The structure to store a batch of directory entries.
+ * @since 1.21
+ */
+struct _Eina_File_Dir_Batch
+{
+   const Eina_File_Dir_Entry *entries; /**< The entries of this batch */
+   unsigned int               count;   /**< The number of entries */
+   const char                *arena;   /**< The nul-terminated paths of all the entries, back to back */
+};
+
+/**
+ * @def EINA_FILE_DIR_ENTRY_PATH
+ * @brief The macro to get the nul-terminated path of an #Eina_File_Dir_Entry.
+ * @param[in] batch The #Eina_File_Dir_Batch the entry belongs to.
+ * @param[in] entry The entry.
+ *
+ * @since 1.21
+ */
+#define EINA_FILE_DIR_ENTRY_PATH(batch, entry) ((batch)->arena + (entry)->path_offset)
+
 /**
  * @def EINA_FILE_DIR_LIST_CB
  * @brief The macro to cast to an #Eina_File_Dir_List_Cb.
@@ -270,6 +421,43 @@ EAPI Eina_Bool eina_file_dir_list(const char           *dir,
                                   Eina_File_Dir_List_Cb cb,
                                   void                 *data) EINA_ARG_NONNULL(1, 3);
 
+/**
+ * @brief Walks a directory tree using several threads.
+ * @details This function calls @p cb for each file and directory below @p dir,
+ *          like eina_file_dir_list() does with @p recursive set to #EINA_TRUE.
+ *          Subdirectories are distributed over a pool of @p threads threads,
+ *          and idle threads steal pending subdirectories from busy ones.
+ *          Directories are opened with openat() relative to their parent,
+ *          so no full path has to be resolved again by the kernel.
+ *
+ *          This function is blocked until the whole tree has been walked.
+ *          Files are reported in no particular order, but a directory is
+ *          always reported before its content.
+ *
+ *          If @p cb or @p dir is @c NULL, or if @p dir is a string of size 0,
+ *          or if @p dir cannot be opened, this function returns #EINA_FALSE
+ *          immediately. Otherwise, it returns #EINA_TRUE.
+ *
+ * @param[in] dir The directory name.
+ * @param[in] threads The number of threads to use. @c 0 uses one thread per
+ *                    available core.
+ * @param[in] cb The callback to be called.
+ * @param[in] data The data to pass to the callback.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE.
+ *
+ * @note @p cb is called from several threads at the same time, and must be
+ *       thread-safe.
+ * @note Symbolic links to directories are reported but not followed.
+ *
+ * @see eina_file_dir_list()
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_walk_parallel(const char       *dir,
+                                       unsigned int      threads,
+                                       Eina_File_Walk_Cb cb,
+                                       const void       *data) EINA_ARG_NONNULL(1, 3);
+
 /**
  * @brief Splits a path according to the delimiter of the filesystem.
  * @details This function splits @p path according to the delimiter of the used
@@ -283,6 +471,25 @@ EAPI Eina_Bool eina_file_dir_list(const char           *dir,
  */
 EAPI Eina_Array    *eina_file_split(char *path) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
 
+/**
+ * @brief Splits a path into slices according to the delimiter of the filesystem.
+ * @details This function is similar to eina_file_split(), but neither allocates
+ *          nor modifies @p path. Each part of @p path is stored into @p slices
+ *          as a pointer inside @p path and a length. Empty parts, as produced by
+ *          repeated separators, are skipped.
+ *
+ * @param[in] path The path to split.
+ * @param[out] slices An array of at least @p count elements to fill.
+ * @param[in] count The number of elements in @p slices.
+ * @return The number of parts in @p path. If it is more than @p count, only
+ *         the first @p count parts were stored.
+ *
+ * @see eina_file_split()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int   eina_file_split_slices(const char *path, Eina_Slice *slices, unsigned int count) EINA_ARG_NONNULL(1);
+
 /**
  * @brief Gets an iterator to list the content of a directory.
  * @details This returns an iterator for shared strings. The name of each file in @p dir will
@@ -349,6 +556,55 @@ EAPI Eina_Iterator *eina_file_stat_ls(const char *dir) EINA_WARN_UNUSED_RESULT E
  */
 EAPI int eina_file_statat(void *container, Eina_File_Direct_Info *info, Eina_Stat *buf) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1, 2, 3);
 
+/**
+ * @brief Calls statx, fstatat or stat, fetching only some of the fields.
+ * @details This function is the same as eina_file_statat(), but only the
+ *          fields of @p buf selected by @p mask are guaranteed to be filled.
+ *          Where statx() is available, only these fields are requested from
+ *          the filesystem, which is much cheaper on network and FUSE
+ *          filesystems. Other fields are set to 0.
+ *
+ * @param[in] container The container returned by #Eina_Iterator using eina_iterator_container_get().
+ * @param[in] info The content of the current #Eina_File_Direct_Info provided by #Eina_Iterator.
+ * @param[in] buf The location puts the result of the stat.
+ * @param[in] mask The fields to fetch.
+ * @return @c 0 is returned on success. Otherwise @c -1 is returned on error and errno is set appropriately.
+ *
+ * @see eina_file_statat()
+ *
+ * @since 1.21
+ */
+EAPI int eina_file_statat_mask(void *container, Eina_File_Direct_Info *info, Eina_Stat *buf, Eina_Stat_Mask mask) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1, 2, 3);
+
+/**
+ * @brief Stats all the entries of a directory batch at once.
+ * @details This function stats every entry of @p batch, fetching only the
+ *          fields selected by @p mask like eina_file_statat_mask() does. The
+ *          requests are all issued before waiting for any of them (using
+ *          io_uring where available), relative to the file descriptor of
+ *          the directory @p container. It is blocked until all of them are
+ *          done.
+ *
+ *          Entries are used in place, so nothing has to be copied out of the
+ *          batch before calling this function.
+ *
+ * @param[in] container The DIR* container returned by eina_iterator_container_get()
+ *                      on the iterator of eina_file_bulk_ls(). It is never @c NULL.
+ * @param[in] batch The current batch of that iterator.
+ * @param[out] bufs An array of @c batch->count elements where the results are put,
+ *                  in the order of the entries.
+ * @param[out] errors If not @c NULL, an array of @c batch->count elements set to
+ *                    @c 0 for each entry that succeeded, or to its errno value.
+ * @param[in] mask The fields to fetch.
+ * @return The number of entries successfully stat'ed.
+ *
+ * @see eina_file_bulk_ls()
+ * @see eina_file_statat_mask()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_statat_batch(void *container, const Eina_File_Dir_Batch *batch, Eina_Stat *bufs, int *errors, Eina_Stat_Mask mask) EINA_ARG_NONNULL(1, 2, 3);
+
 /**
  * @brief Generates and creates a uniquely named temporary file from a template name.
  *        The generated file is opened with the open(2) @c O_EXCL flag.
@@ -433,6 +689,110 @@ EAPI Eina_Bool eina_file_mkdtemp(const char *templatename, Eina_Tmpstr **path) E
  */
 EAPI Eina_Iterator *eina_file_direct_ls(const char *dir) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
 
+/**
+ * @brief Gets an iterator to list the content of a directory in batches.
+ * @details This returns an iterator for #Eina_File_Dir_Batch. Entries are read
+ *          from the directory with large buffers (using getdents64 where
+ *          available), and each step of the iterator gives the entries read by
+ *          one buffer fill as a single batch. Paths of a batch are packed in one
+ *          arena instead of an #EINA_PATH_MAX buffer per entry, which makes
+ *          this much cheaper than eina_file_direct_ls() on big directories.
+ *
+ * @param [in] dir The name of the directory to list.
+ *
+ * @return An Eina_Iterator that walks over batches of the files and
+ *         directories in @p dir. On failure, it returns @c NULL.
+ *
+ * @warning File type information is as reliable as with eina_file_direct_ls().
+ *          Entries may thus be of type EINA_FILE_UNKNOWN.
+ * @warning The #Eina_File_Dir_Batch returned by the iterator <b>must not</b>
+ *          be modified in any way.
+ * @warning When the iterator is advanced or deleted, the #Eina_File_Dir_Batch
+ *          returned, its entries and its arena are no longer valid.
+ *
+ * @note The container for the iterator is of type DIR*, as with
+ *       eina_file_direct_ls(). Entries are read from its file descriptor,
+ *       returned by dirfd(). Use eina_file_statat_batch() to stat the
+ *       entries of a batch, since eina_file_statat() expects an
+ *       #Eina_File_Direct_Info.
+ * @note The iterator skips '.' and '..'. A batch is never empty.
+ *
+ * @see eina_file_direct_ls()
+ *
+ * @since 1.21
+ */
+EAPI Eina_Iterator *eina_file_bulk_ls(const char *dir) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
+
+/**
+ * @brief Enables caching of the listing of a directory.
+ * @details Once enabled, the content of @p dir is read the next time it is
+ *          listed with eina_file_ls(), eina_file_direct_ls() or
+ *          eina_file_stat_ls(), and later listings are served from memory
+ *          without reading the directory again. The cache is invalidated
+ *          by inotify when it is available, or by checking the modification
+ *          time of @p dir before each listing otherwise.
+ *
+ * @param[in] dir The directory to cache. It should be an absolute path.
+ * @return #EINA_TRUE if the cache was enabled. Otherwise, #EINA_FALSE.
+ *
+ * @note The container of the iterators served from the cache is not a DIR*.
+ *       The directory is only opened if eina_file_statat() is called on it.
+ * @note Only the names of the files and the types reported by the directory
+ *       itself, as eina_file_direct_ls() returns them, are cached. On a cache
+ *       hit, eina_file_stat_ls() still resolves the entries of type
+ *       EINA_FILE_UNKNOWN or EINA_FILE_LNK with fstatat(), so its type
+ *       information stays correct, even when the target of a symbolic link
+ *       changes without the directory changing. Cached listings of
+ *       eina_file_stat_ls() are thus only as cheap as those of
+ *       eina_file_direct_ls() when the directory reports the file types and
+ *       holds no symbolic links.
+ *
+ * @see eina_file_ls_cache_del()
+ * @see eina_file_ls_cache_save()
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_ls_cache_add(const char *dir) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Disables caching of the listing of a directory.
+ * @details The cached listing of @p dir, if any, is dropped.
+ *
+ * @param[in] dir The directory given to eina_file_ls_cache_add().
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_ls_cache_del(const char *dir) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Saves all the cached directory listings to a file.
+ * @details The file is written in a format that is mapped as is by
+ *          eina_file_ls_cache_load(), so loading it costs almost nothing.
+ *          It is written to a temporary file first and then renamed, so
+ *          concurrent loads never see a partial snapshot.
+ *
+ * @param[in] path The file to write.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_ls_cache_save(const char *path) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Loads directory listings saved by eina_file_ls_cache_save().
+ * @details Every directory in the snapshot gets its cache enabled as with
+ *          eina_file_ls_cache_add(). The listing of a directory whose
+ *          modification time changed since the snapshot was saved is
+ *          discarded and read again on next use.
+ *
+ * @param[in] path The file to load.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE if the file does not
+ *         exist or is not a valid snapshot.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_ls_cache_load(const char *path) EINA_ARG_NONNULL(1);
+
 /**
  * @brief Sanitizes the file path.
  * @details This function takes care of adding the current working directory if it is a
@@ -447,6 +807,66 @@ EAPI Eina_Iterator *eina_file_direct_ls(const char *dir) EINA_WARN_UNUSED_RESULT
  */
 EAPI char *eina_file_path_sanitize(const char *path);
 
+/**
+ * @brief Sanitizes the file path into a buffer.
+ * @details This function does what eina_file_path_sanitize() does, but writes
+ *          the result into @p dst instead of allocating it. The path is
+ *          scanned for '/./', '//' and '..' segments a word at a time, so a
+ *          path that is already clean is just copied.
+ *
+ * @param[in] path The path to sanitize.
+ * @param[out] dst The buffer to store the result. It may be @c NULL if
+ *                 @p size is @c 0.
+ * @param[in] size Size, in bytes, of the buffer.
+ * @return The length of the sanitized path, excluding the trailing nul byte.
+ *         If it is @p size or more, the result was truncated. @c 0 is
+ *         returned on failure.
+ *
+ * @note @p dst is always nul-terminated, unless @p size is @c 0. As with
+ *       snprintf(), calling this function with a @c NULL @p dst and a
+ *       @p size of @c 0 returns the size of the buffer needed, minus one.
+ *
+ * @see eina_file_path_sanitize()
+ *
+ * @since 1.21
+ */
+EAPI size_t eina_file_path_sanitize_buf(const char *path, char *dst, size_t size) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Sanitizes the file path and returns it as a stringshare.
+ * @details This function does what eina_file_path_sanitize() does, but
+ *          remembers the result for @p path, so sanitizing the same path
+ *          again only costs a lookup and a new reference. A relative
+ *          @p path is never remembered, as its result depends on the
+ *          current working directory.
+ *
+ *          The results are kept in a cache of at most 1024 paths by default.
+ *          When it is full, the least recently used path is dropped. Strings
+ *          already returned stay valid until they are released.
+ *
+ * @param[in] path The path to sanitize.
+ * @return The stringshared sanitized path, or @c NULL on failure. It must be
+ *         released with eina_stringshare_del().
+ *
+ * @see eina_file_path_sanitize()
+ * @see eina_file_path_sanitize_cache_max_set()
+ *
+ * @since 1.21
+ */
+EAPI const char *eina_file_path_sanitize_stringshare(const char *path) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Sets the size of the cache of eina_file_path_sanitize_stringshare().
+ * @details If the cache holds more paths than @p count, the least recently
+ *          used ones are dropped right away. A @p count of @c 0 disables and
+ *          flushes the cache.
+ *
+ * @param[in] count The maximum number of paths to remember.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_path_sanitize_cache_max_set(unsigned int count);
+
 /**
  * @typedef Eina_File_Copy_Progress
  * @brief Type for a callback to report file copy progress.
@@ -484,6 +904,135 @@ typedef enum {
  */
 EAPI Eina_Bool eina_file_copy(const char *src, const char *dst, Eina_File_Copy_Flags flags, Eina_File_Copy_Progress cb, const void *cb_data) EINA_ARG_NONNULL(1, 2);
 
+/**
+ * @typedef Eina_File_Copy
+ * @brief A handle to a copy running in the background.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Copy Eina_File_Copy;
+
+/**
+ * @typedef Eina_File_Copy_Done
+ * @brief Type for a callback to report the end of an asynchronous file copy.
+ * @details This function is called exactly once per eina_file_copy_async(), with
+ *          @p success set to #EINA_TRUE if the whole file was copied. The
+ *          #Eina_File_Copy handle stays valid after it returns, until it is
+ *          released with eina_file_copy_free().
+ *
+ * @since 1.21
+ */
+typedef void (*Eina_File_Copy_Done)(void *data, const char *src, const char *dst, Eina_Bool success);
+
+/**
+ * @brief Copies one file to another in the background.
+ * @details This function starts copying @p src to @p dst and returns right away.
+ *          It uses the fastest method available, like reflinks, copy_file_range()
+ *          or io_uring, and falls back to what eina_file_copy() does otherwise.
+ *          Big files are split in extents that are copied concurrently.
+ *
+ *          All the copies share a small pool of threads and, when io_uring is
+ *          available, a single submission ring, so starting many copies
+ *          does not start as many threads.
+ *
+ * @param[in] src The source file.
+ * @param[in] dst The destination file.
+ * @param[in] flags Controls what is copied. (Data is always copied.)
+ * @param[in] progress_cb If it is provided, it will be called with the file copy progress information.
+ *                        Returning #EINA_FALSE from it cancels the copy.
+ * @param[in] done_cb The function to call once the copy is over.
+ * @param[in] cb_data Context data to provide to @p progress_cb and @p done_cb.
+ * @return A handle to the copy, or @c NULL if it could not be started, in
+ *         which case @p done_cb is not called. The handle must be released
+ *         with eina_file_copy_free(), before or after the copy is over.
+ *
+ * @note @p progress_cb and @p done_cb are called from an internal thread, and
+ *       must be thread-safe. The progress reported is the total of all the
+ *       extents, and is only increasing.
+ *
+ * @note On failure or cancellation, @p dst is deleted before @p done_cb is called.
+ *
+ * @see eina_file_copy()
+ * @see eina_file_copy_cancel()
+ * @see eina_file_copy_free()
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Copy *eina_file_copy_async(const char *src, const char *dst, Eina_File_Copy_Flags flags, Eina_File_Copy_Progress progress_cb, Eina_File_Copy_Done done_cb, const void *cb_data) EINA_ARG_NONNULL(1, 2, 5);
+
+/**
+ * @brief Cancels a copy started with eina_file_copy_async().
+ * @details The copy stops as soon as possible, and its done callback is called
+ *          with a failure. It may still be called before this function returns.
+ *
+ *          Cancelling a copy that is already over does nothing, and its done
+ *          callback is not called again. This is always safe, since the
+ *          handle stays valid until eina_file_copy_free().
+ *
+ * @param[in] copy The copy to cancel.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_copy_cancel(Eina_File_Copy *copy);
+
+/**
+ * @brief Releases the handle of a copy started with eina_file_copy_async().
+ * @details If the copy is still running, it keeps running and its done
+ *          callback is still called, but @p copy can not be used anymore.
+ *          Call eina_file_copy_cancel() first to stop it.
+ *
+ * @param[in] copy The copy to release.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_copy_free(Eina_File_Copy *copy);
+
+/**
+ * @typedef Eina_File_Copy_Pair
+ * @brief A type for #_Eina_File_Copy_Pair.
+ * @since 1.21
+ */
+typedef struct _Eina_File_Copy_Pair Eina_File_Copy_Pair;
+
+/**
+ * @struct _Eina_File_Copy_Pair
+ * @brief The structure to describe one of the copies done by eina_file_copy_batch().
+ * @since 1.21
+ */
+struct _Eina_File_Copy_Pair
+{
+   const char *src;     /**< The source file */
+   const char *dst;     /**< The destination file */
+   Eina_Bool   success; /**< Set by eina_file_copy_batch() to #EINA_TRUE if this file was copied */
+};
+
+/**
+ * @brief Copies many files at once using the fastest possible method. Also, reports progress.
+ * @details This function copies every @c src of @p pairs to its @c dst. Opening the files,
+ *          copying their data and applying the metadata selected by @p flags
+ *          are pipelined over a small pool of threads, which makes copying many
+ *          small files much faster than calling eina_file_copy() for each of them.
+ *          It is blocked until all the files have been copied or have failed.
+ *
+ *          A failed copy does not stop the others. Its destination is deleted
+ *          and its @c success field is set to #EINA_FALSE.
+ *
+ * @param[in,out] pairs The files to copy.
+ * @param[in] count The number of elements in @p pairs.
+ * @param[in] flags Controls what is copied. (Data is always copied.)
+ * @param[in] cb If it is provided, it will be called with the progress information
+ *               of the whole batch, in bytes. Returning #EINA_FALSE stops the copies
+ *               that are not finished yet.
+ * @param[in] cb_data Context data to provide to @p cb during copy.
+ * @return The number of files successfully copied.
+ *
+ * @note @p cb is always called from the thread calling this function.
+ *
+ * @see eina_file_copy()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_copy_batch(Eina_File_Copy_Pair *pairs, unsigned int count, Eina_File_Copy_Flags flags, Eina_File_Copy_Progress cb, const void *cb_data) EINA_ARG_NONNULL(1);
+
 /**
  * @brief Gets a read-only handler to a file.
  * @details Opens a file in a read-only mode. @p name should be an absolute path. An
@@ -524,6 +1073,72 @@ eina_file_virtualize(const char *virtual_name, const void *data, unsigned long l
 EAPI Eina_Bool
 eina_file_virtual(Eina_File *file) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1);
 
+/**
+ * @brief Creates a pack of virtual files from a single memory blob.
+ * @details Each member becomes a virtual file that is created on demand by
+ *          eina_file_pack_open(), without copying its content. Mapping such a
+ *          file returns a pointer inside @p data. Members are indexed by
+ *          name, so looking one up does not depend on the size of the pack.
+ *
+ * @param[in] data The memory pointer holding the content of all the members.
+ * @param[in] length The length of the data in memory.
+ * @param[in] members The description of the members. Names are copied.
+ * @param[in] count The number of elements in @p members.
+ * @return A new pack, or @c NULL if a member is outside of @p data or if a
+ *         name is used twice.
+ *
+ * @note @p data is not copied and must stay valid until the pack and all the
+ *       files opened from it are closed.
+ *
+ * @see eina_file_pack_file_new()
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Pack *
+eina_file_pack_new(const void *data, unsigned long long length, const Eina_File_Pack_Member *members, unsigned int count) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1, 3) EINA_MALLOC;
+
+/**
+ * @brief Creates a pack of virtual files from the content of a file.
+ * @details This is the same as eina_file_pack_new(), but the content of the
+ *          members is mapped from @p archive. The pack holds a reference on
+ *          @p archive.
+ *
+ * @param[in] archive The file holding the content of all the members.
+ * @param[in] members The description of the members. Names are copied.
+ * @param[in] count The number of elements in @p members.
+ * @return A new pack, or @c NULL on failure.
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Pack *
+eina_file_pack_file_new(Eina_File *archive, const Eina_File_Pack_Member *members, unsigned int count) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1, 2) EINA_MALLOC;
+
+/**
+ * @brief Opens a member of a pack as a virtual file.
+ *
+ * @param[in] pack The pack to look into.
+ * @param[in] name The name of the member.
+ * @return An #Eina_File handle to the member, or @c NULL if there is no such
+ *         member. It must be closed with eina_file_close().
+ *
+ * @note eina_file_virtual() returns #EINA_TRUE on the returned file.
+ *
+ * @since 1.21
+ */
+EAPI Eina_File *
+eina_file_pack_open(Eina_File_Pack *pack, const char *name) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1, 2);
+
+/**
+ * @brief Frees a pack.
+ * @details Files already opened from @p pack stay valid until they are closed.
+ *
+ * @param[in] pack The pack to free.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_file_pack_free(Eina_File_Pack *pack);
+
 /**
  * @brief Refreshes file information.
  * @details All current maps continue to exist. You need to manually delete
@@ -536,6 +1151,31 @@ eina_file_virtual(Eina_File *file) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1);
  */
 EAPI Eina_Bool eina_file_refresh(Eina_File *file);
 
+/**
+ * @brief Refreshes the information of many files at once.
+ * @details This function does what eina_file_refresh() does on each element
+ *          of @p files, but only the files that changed cost anything. Files
+ *          are watched with inotify or kqueue where available, so only the
+ *          files reported by the watch are stat'ed again. The first call on
+ *          a file adds it to the watch set. Without such a facility, all the
+ *          files are stat'ed in one batch.
+ *
+ *          As with eina_file_refresh(), all current maps continue to exist.
+ *
+ * @param[in,out] files The files to refresh.
+ * @param[in] count The number of elements in @p files.
+ * @param[out] changed An array of at least @p count elements, where the files
+ *                     that changed are stored, in the order of @p files.
+ * @return The number of files stored in @p changed.
+ *
+ * @note Virtual files never change.
+ *
+ * @see eina_file_refresh()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_refresh_many(Eina_File **files, unsigned int count, Eina_File **changed) EINA_ARG_NONNULL(1, 3);
+
 /**
  * @brief Duplicates a read-only handler of a previously opened file.
  *
@@ -558,6 +1198,76 @@ EAPI Eina_File * eina_file_dup(const Eina_File *file);
  */
 EAPI void eina_file_close(Eina_File *file);
 
+/**
+ * @brief Gets a read-write handler to a file.
+ * @details Opens or creates @p name for writing. If the file is smaller than
+ *          @p size bytes, it is grown to @p size bytes, and the new space is
+ *          allocated on disk (using fallocate where available), so writing
+ *          through a map does not fail for lack of space. A file bigger than
+ *          @p size is never truncated by this function: with
+ *          #EINA_FILE_WRITE_DEFAULT, all its content is kept. Use
+ *          eina_file_resize() to shrink it. All the read-only functions work
+ *          on the returned handle, and eina_file_size_get() returns the
+ *          resulting size.
+ *
+ *          With #EINA_FILE_WRITE_ATOMIC, the data is written to a temporary
+ *          file created by eina_file_mkstemp() in the directory of @p name.
+ *          Readers never see a partially written file.
+ *
+ * @param[in] name The filename to open.
+ * @param[in] flags Controls how the file is opened.
+ * @param[in] size The minimal size, in bytes, of the file.
+ * @return An #Eina_File handle to the file, or @c NULL on failure.
+ *
+ * @note Handles opened with this function are never shared with
+ *       eina_file_open().
+ * @note eina_file_filename_get() always returns @p name, even for a handle
+ *       opened with #EINA_FILE_WRITE_ATOMIC. The name of the temporary file
+ *       is not exposed.
+ *
+ * @see eina_file_map_write_new()
+ * @see eina_file_publish()
+ *
+ * @since 1.21
+ */
+EAPI Eina_File *eina_file_open_rw(const char *name, Eina_File_Write_Flags flags, unsigned long long size) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
+
+/**
+ * @brief Changes the size of a file opened with eina_file_open_rw().
+ * @details Growing the file allocates the new space on disk. Shrinking it
+ *          is not allowed while a map covers the truncated part.
+ *
+ * @param[in,out] file The file to resize.
+ * @param[in] size The new size, in bytes.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_resize(Eina_File *file, unsigned long long size) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Publishes a file opened with #EINA_FILE_WRITE_ATOMIC.
+ * @details Syncs all the data of @p file to disk, and then renames the
+ *          temporary file over the target, so readers see either the old
+ *          content or the whole new one. Closing the file without calling
+ *          this function deletes the temporary file.
+ *
+ *          After a successful publish, @p file and its maps stay valid and
+ *          writable, but they now refer to the published file in place:
+ *          later changes are seen by readers as they are made, and are no
+ *          longer atomic.
+ *
+ * @param[in,out] file The file to publish.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE, and the target is
+ *         left untouched.
+ *
+ * @note On files opened without #EINA_FILE_WRITE_ATOMIC, or already
+ *       published, this only syncs the data to disk.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_publish(Eina_File *file) EINA_ARG_NONNULL(1);
+
 /**
  * @brief Gets the file size at open time.
  *
@@ -615,6 +1325,112 @@ EAPI Eina_Iterator *eina_file_xattr_get(Eina_File *file);
  */
 EAPI Eina_Iterator *eina_file_xattr_value_get(Eina_File *file);
 
+/**
+ * @brief Creates a buffer to fetch the given extended attributes of files.
+ * @details The buffer is meant to be reused with eina_file_xattr_batch_fetch()
+ *          on many files. It grows to fit the biggest values seen, and is never
+ *          reallocated after that.
+ *
+ * @param[in] names The names of the extended attributes to fetch. They are copied.
+ * @param[in] count The number of elements in @p names.
+ * @return A new buffer, or @c NULL on failure.
+ *
+ * @note Neither @p names nor the strings it points to are modified, so arrays
+ *       of string literals and const char ** arrays are accepted as is. In C,
+ *       unlike C++, a char ** array still needs a cast, as C has no implicit
+ *       conversion from char ** to const char * const *.
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Xattr_Batch *eina_file_xattr_batch_new(const char * const *names, unsigned int count) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
+
+/**
+ * @brief Fetches the extended attributes of a file into a buffer.
+ * @details This function replaces the content of @p batch with the values of
+ *          its attributes for @p file. Only the requested attributes are read,
+ *          without listing the attributes first.
+ *
+ *          Values read are also cached in @p file, along with the status
+ *          change time (ctime) of the file at that moment. Changing an extended
+ *          attribute updates the ctime, but not the modification time. Later
+ *          fetches of the same attributes on @p file only stat the file, and
+ *          are served from the cache as long as its ctime did not change.
+ *
+ * @param[in,out] batch The buffer to fill.
+ * @param[in] file The file to fetch the attributes of.
+ * @return The number of attributes found on @p file.
+ *
+ * @note On filesystems that do not update the ctime reliably, use
+ *       eina_file_xattr_cache_flush() to see changes.
+ *
+ * @see eina_file_xattr_batch_fetch_many()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_xattr_batch_fetch(Eina_File_Xattr_Batch *batch, Eina_File *file) EINA_ARG_NONNULL(1, 2);
+
+/**
+ * @typedef Eina_File_Xattr_Batch_Cb
+ * @brief Type for a callback called for each file by eina_file_xattr_batch_fetch_many().
+ * @param[in] data The data passed to eina_file_xattr_batch_fetch_many()
+ * @param[in] file The file whose attributes were fetched
+ * @param[in] batch The buffer holding the values of @p file, only valid during the call
+ * @param[in] found The number of attributes found on @p file
+ * @return #EINA_FALSE to stop fetching the attributes of the remaining files.
+ * @since 1.21
+ */
+typedef Eina_Bool (*Eina_File_Xattr_Batch_Cb)(void *data, Eina_File *file, const Eina_File_Xattr_Batch *batch, unsigned int found);
+
+/**
+ * @brief Fetches the extended attributes of many files into a buffer.
+ * @details This function does what eina_file_xattr_batch_fetch() does on each
+ *          element of @p files, in a single pass reusing the memory of
+ *          @p batch, and calls @p cb once the values of each file are ready.
+ *
+ * @param[in,out] batch The buffer to fill.
+ * @param[in] files The files to fetch the attributes of.
+ * @param[in] count The number of elements in @p files.
+ * @param[in] cb The callback to be called for each file.
+ * @param[in] data The data to pass to the callback.
+ * @return The number of files for which @p cb was called.
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_xattr_batch_fetch_many(Eina_File_Xattr_Batch *batch, Eina_File **files, unsigned int count, Eina_File_Xattr_Batch_Cb cb, const void *data) EINA_ARG_NONNULL(1, 2, 4);
+
+/**
+ * @brief Drops the extended attributes cached in a file.
+ * @details The next fetch on @p file reads all the requested attributes
+ *          from the filesystem again.
+ *
+ * @param[in,out] file The file to drop the cache of.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_xattr_cache_flush(Eina_File *file) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Gets a value fetched by eina_file_xattr_batch_fetch().
+ *
+ * @param[in] batch The buffer.
+ * @param[in] idx The index of the attribute, in the array given to eina_file_xattr_batch_new().
+ * @param[out] length If not @c NULL, set to the length of the value.
+ * @return The value, or @c NULL if the file does not have this attribute. It is
+ *         only valid until the next fetch into @p batch.
+ *
+ * @since 1.21
+ */
+EAPI const void *eina_file_xattr_batch_value_get(const Eina_File_Xattr_Batch *batch, unsigned int idx, size_t *length) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Frees a buffer created by eina_file_xattr_batch_new().
+ *
+ * @param[in] batch The buffer to free.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_xattr_batch_free(Eina_File_Xattr_Batch *batch);
+
 /**
  * @brief Maps all the files to a buffer.
  *
@@ -639,6 +1455,10 @@ EAPI void *eina_file_map_all(Eina_File *file, Eina_File_Populate rule);
  *
  * @note This handles reference counting so it can share the same memory area.
  *
+ * @note With #EINA_FILE_POPULATE or #EINA_FILE_LOCK, the memory is populated
+ *       while it is mapped (using MAP_POPULATE where available), instead of
+ *       being faulted in on first access.
+ *
  * @since 1.1
  */
 EAPI void *eina_file_map_new(Eina_File *file, Eina_File_Populate rule,
@@ -666,6 +1486,9 @@ EAPI void eina_file_map_free(Eina_File *file, void *map);
  * @param[in] map Memory that was mapped inside of what the memory range is.
  * @param[in] offset The offset, in bytes, from the start of the map address.
  * @param[in] length The length, in bytes, of the memory region to populate.
+ *
+ * @note With #EINA_FILE_HUGEPAGE, only the part of the range that is aligned
+ *       on the huge page size can be affected.
  * 
  * @since 1.8
  */
@@ -673,6 +1496,73 @@ EAPI void
 eina_file_map_populate(Eina_File *file, Eina_File_Populate rule, const void *map,
                        unsigned long int offset, unsigned long int length);
 
+/**
+ * @brief Creates a queue of ranges to prefetch in the background.
+ * @details Ranges added to the queue with eina_file_prefetch_add() are read
+ *          ahead by a background thread, in the order they were added, using
+ *          readahead, #EINA_FILE_WILLNEED or MADV_POPULATE_READ depending on
+ *          what the system supports. At most @p budget bytes are prefetched
+ *          ahead of what eina_file_prefetch_done() reported as consumed,
+ *          so the prefetched data does not push itself out of the page cache.
+ *
+ * @param[in] budget The maximum number of bytes to prefetch ahead of consumption.
+ * @return A new prefetch queue, or @c NULL on failure.
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Prefetch *eina_file_prefetch_new(unsigned long long budget) EINA_WARN_UNUSED_RESULT EINA_MALLOC;
+
+/**
+ * @brief Changes the budget of a prefetch queue.
+ *
+ * @param[in,out] pf The prefetch queue.
+ * @param[in] budget The maximum number of bytes to prefetch ahead of consumption.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_prefetch_budget_set(Eina_File_Prefetch *pf, unsigned long long budget) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Adds a range of a mapped file to a prefetch queue.
+ *
+ * @param[in,out] pf The prefetch queue.
+ * @param[in] file The file handle where the map comes from.
+ * @param[in] map Memory that was mapped inside of what the memory range is.
+ * @param[in] offset The offset, in bytes, from the start of the map address.
+ * @param[in] length The length, in bytes, of the memory region to prefetch.
+ * @return #EINA_TRUE if the range was queued. Otherwise, #EINA_FALSE.
+ *
+ * @note @p map must stay mapped until the range has been reported as
+ *       consumed with eina_file_prefetch_done(), or until @p pf is freed.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_prefetch_add(Eina_File_Prefetch *pf, Eina_File *file, const void *map,
+                                      unsigned long int offset, unsigned long int length) EINA_ARG_NONNULL(1, 2, 3);
+
+/**
+ * @brief Reports that some of the queued data has been consumed.
+ * @details Ranges are consumed in the order they were added. Consuming data
+ *          that has not been prefetched yet drops it from the queue.
+ *
+ * @param[in,out] pf The prefetch queue.
+ * @param[in] length The number of bytes consumed since the last call.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_prefetch_done(Eina_File_Prefetch *pf, unsigned long long length) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Frees a prefetch queue.
+ * @details Pending ranges are dropped. This function waits for the range
+ *          currently being prefetched, if any.
+ *
+ * @param[in] pf The prefetch queue to free.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_prefetch_free(Eina_File_Prefetch *pf);
+
 /**
  * @brief Maps line-by-line in the memory by efficiently using an #Eina_Iterator.
  * @details This function returns an iterator that acts like fgets without
@@ -682,10 +1572,214 @@ eina_file_map_populate(Eina_File *file, Eina_File_Populate rule, const void *map
  * @param[in] file The file to run over.
  * @return An Eina_Iterator that produces #Eina_File_Line.
  *
+ * @see eina_file_map_lines_batch()
+ *
  * @since 1.3
  */
 EAPI Eina_Iterator *eina_file_map_lines(Eina_File *file);
 
+/**
+ * @brief Fetches several lines at once from a line iterator.
+ * @details This function advances @p it by up to @p count lines and stores
+ *          them into @p lines, avoiding one call to eina_iterator_next()
+ *          per line. All the returned lines stay mapped until the next call
+ *          to eina_iterator_next() or to this function on @p it, or until
+ *          @p it is freed.
+ *
+ * @param[in,out] it An iterator returned by eina_file_map_lines() or
+ *                   eina_file_map_lines_split().
+ * @param[out] lines An array of at least @p count elements to fill.
+ * @param[in] count The maximum number of lines to fetch.
+ * @return The number of lines stored in @p lines. @c 0 means the end of
+ *         the file or of the chunk has been reached, or @p it does not come
+ *         from eina_file_map_lines() or eina_file_map_lines_split().
+ *
+ * @see eina_file_map_lines()
+ * @see eina_file_map_lines_split()
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_map_lines_batch(Eina_Iterator *it, Eina_File_Line *lines, unsigned int count) EINA_ARG_NONNULL(1, 2);
+
+/**
+ * @brief Splits a file in line-aligned chunks, each with its own line iterator.
+ * @details This function cuts @p file in up to @p n_chunks ranges of similar
+ *          size, moving every cut to just after the next end of line. Each
+ *          range gets an iterator that behaves like the one returned by
+ *          eina_file_map_lines(), but only maps its own range using
+ *          eina_file_map_new(). The iterators are independent and can be
+ *          advanced from different threads at the same time.
+ *
+ *          The @c index of the lines produced by each iterator starts over
+ *          at the beginning of its chunk. To get the line number in the
+ *          whole file, add the eina_file_map_lines_count() of all the
+ *          previous chunks, once they have been fully iterated.
+ *
+ * @param[in] file The file to run over.
+ * @param[in] n_chunks The number of chunks wanted.
+ * @return An array of #Eina_Iterator, in file order, or @c NULL on failure.
+ *         Fewer than @p n_chunks iterators are returned if the file is too
+ *         small or does not contain enough lines. Each iterator, and then the
+ *         array, must be freed by the caller.
+ *
+ * @see eina_file_map_lines()
+ *
+ * @since 1.21
+ */
+EAPI Eina_Array *eina_file_map_lines_split(Eina_File *file, unsigned int n_chunks) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
+
+/**
+ * @brief Gets the number of lines a line iterator has produced so far.
+ *
+ * @param[in] it An iterator returned by eina_file_map_lines() or
+ *               eina_file_map_lines_split().
+ * @return The number of lines produced. Once @p it has reached its end,
+ *         this is the number of lines in the file or in the chunk.
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_map_lines_count(Eina_Iterator *it) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Builds an index of the lines of a file and saves it.
+ * @details This function scans @p file once, like eina_file_map_lines(), and
+ *          writes the offset of every line to @p index_path in a format that
+ *          is mapped as is. The size and modification time of @p file are
+ *          stored along, so a stale index is detected. The index is then
+ *          attached to @p file, as with eina_file_line_index_load().
+ *
+ * @param[in] file The file to index.
+ * @param[in] index_path The file to write the index to. It is written to a
+ *                       temporary file first and then renamed.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE.
+ *
+ * @see eina_file_line_get()
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_line_index_build(Eina_File *file, const char *index_path) EINA_ARG_NONNULL(1, 2);
+
+/**
+ * @brief Attaches a previously built line index to a file.
+ *
+ * @param[in] file The file the index was built for.
+ * @param[in] index_path The file written by eina_file_line_index_build().
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE if the index does not
+ *         exist, is invalid, or does not match eina_file_size_get() and
+ *         eina_file_mtime_get() of @p file anymore.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_line_index_load(Eina_File *file, const char *index_path) EINA_ARG_NONNULL(1, 2);
+
+/**
+ * @brief Gets the number of lines of a file with a line index.
+ *
+ * @param[in] file The file, with an index attached.
+ * @return The number of lines, or @c 0 if no index is attached to @p file.
+ *
+ * @since 1.21
+ */
+EAPI unsigned int eina_file_line_count_get(const Eina_File *file) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Gets a line of a file in constant time.
+ * @details This function looks @p n up in the line index attached to @p file,
+ *          and fills @p line as eina_file_map_lines() would for this line,
+ *          without scanning the file. The whole file is mapped on first use,
+ *          and stays mapped until @p file is closed or the index is dropped.
+ *
+ * @param[in] file The file, with an index attached.
+ * @param[in] n The number of the line, as in the @c index field produced by
+ *              eina_file_map_lines().
+ * @param[out] line The line to fill.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE if @p n is out of
+ *         range or no index is attached to @p file.
+ *
+ * @note The index is dropped when eina_file_refresh() reports a change.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_line_get(Eina_File *file, unsigned int n, Eina_File_Line *line) EINA_ARG_NONNULL(1, 3);
+
+/**
+ * @brief Creates a sliding window to map a file piece by piece.
+ * @details This function creates a window of @p window_size bytes that
+ *          maps only the part of @p file it currently looks at. Moving the
+ *          window maps the new range on demand and releases the previous
+ *          one with #EINA_FILE_DONTNEED, while the next range is prefetched
+ *          with #EINA_FILE_WILLNEED. At most two ranges are mapped at any
+ *          time, which keeps memory usage and the number of mappings bounded
+ *          no matter how big the file is.
+ *
+ *          The window initially looks at the start of the file. Offsets in
+ *          the file are 64 bits wide on all platforms, so files bigger than
+ *          4 GiB can be walked on 32 bits systems too.
+ *
+ * @param[in] file The file to map.
+ * @param[in] window_size The size, in bytes, of each window. It is rounded up
+ *                        to a multiple of the page size.
+ * @param[in] rule The rule to apply to each mapped window.
+ * @return A new window, or @c NULL on failure.
+ *
+ * @see eina_file_map_window_get()
+ * @see eina_file_map_window_free()
+ *
+ * @since 1.21
+ */
+EAPI Eina_File_Map_Window *eina_file_map_window_new(Eina_File *file, unsigned long int window_size, Eina_File_Populate rule) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_MALLOC;
+
+/**
+ * @brief Gets the memory the window currently looks at.
+ *
+ * @param[in] win The window.
+ * @param[out] offset If not @c NULL, set to the offset of the window in the file.
+ * @param[out] length If not @c NULL, set to the number of valid bytes in the
+ *                    window. It is smaller than the window size at the end
+ *                    of the file.
+ * @return A pointer to the mapped memory, or @c NULL if the mapping failed.
+ *
+ * @note The memory stays valid until the window is moved or freed.
+ *
+ * @since 1.21
+ */
+EAPI const void *eina_file_map_window_get(const Eina_File_Map_Window *win, unsigned long long *offset, unsigned long int *length) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Moves the window to the next range of the file.
+ *
+ * @param[in,out] win The window.
+ * @return #EINA_TRUE if the window moved. Otherwise, #EINA_FALSE at the end
+ *         of the file or if the mapping failed.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_map_window_advance(Eina_File_Map_Window *win) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Moves the window so that it contains the given offset.
+ * @details The window is aligned on the page size, so @p offset may not be
+ *          at the start of the window. Use eina_file_map_window_get() to
+ *          find out where it actually starts.
+ *
+ * @param[in,out] win The window.
+ * @param[in] offset The offset inside the file.
+ * @return #EINA_TRUE if the window moved. Otherwise, #EINA_FALSE if @p offset
+ *         is not inside the file or if the mapping failed.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_map_window_seek(Eina_File_Map_Window *win, unsigned long long offset) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Frees a window and unmaps all its memory.
+ *
+ * @param[in] win The window to free.
+ *
+ * @since 1.21
+ */
+EAPI void eina_file_map_window_free(Eina_File_Map_Window *win);
+
 /**
  * @brief Tells whether there has been an IO error during the life of a mmaped file.
  *
@@ -697,6 +1791,38 @@ EAPI Eina_Iterator *eina_file_map_lines(Eina_File *file);
  */
 EAPI Eina_Bool eina_file_map_faulted(Eina_File *file, void *map);
 
+/**
+ * @brief Maps a part of the file for writing.
+ * @details This function is the same as eina_file_map_new(), but the memory
+ *          is writeable and changes are written back to the file. The map
+ *          must be released with eina_file_map_free().
+ *
+ * @param[in] file A file handler opened with eina_file_open_rw().
+ * @param[in] offset The offset inside the file. It is 64 bits wide on all
+ *                   platforms, so files bigger than 4 GiB can be written
+ *                   on 32 bits systems too.
+ * @param[in] length The length of the memory to map.
+ * @return A valid pointer to the system memory with @p length valid bytes in it \n.
+ *         @c NULL if it is not inside the file, if @p file is read-only, or
+ *         something else goes wrong.
+ *
+ * @since 1.21
+ */
+EAPI void *eina_file_map_write_new(Eina_File *file, unsigned long long offset, unsigned long int length) EINA_ARG_NONNULL(1);
+
+/**
+ * @brief Writes back the changes made to a map.
+ *
+ * @param[in] file The file handle where the map comes from.
+ * @param[in] map The map returned by eina_file_map_write_new().
+ * @param[in] wait #EINA_TRUE to wait until the data is on disk. Otherwise, the
+ *                 write back is only scheduled.
+ * @return #EINA_TRUE on success. Otherwise, #EINA_FALSE.
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool eina_file_map_sync(Eina_File *file, void *map, Eina_Bool wait) EINA_ARG_NONNULL(1, 2);
+
 /**
  * @brief Joins two paths of a known length.
  * @details This function is similar to eina_str_join_len(), but the separator
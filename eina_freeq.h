@@ -84,6 +84,12 @@
  * less than the maximum. You can adjust the maximum 
  * with EINA_FREEQ_FILL_MAX.
  *
+ * EINA_FREEQ_THREAD_CACHE=N
+ *
+ * Sets the default number of items each thread may buffer before they
+ * are moved to the free queue. The default value is 0, which disables
+ * the per-thread cache. See eina_freeq_thread_cache_set().
+ *
  * @since 1.19
  * 
  * @typedef Eina_FreeQ
@@ -138,8 +144,104 @@ EINA_FREEQ_DEFAULT,
 */
    
 EINA_FREEQ_POSTPONED,
+
+/** @brief Recycling free queue.
+*
+* Recycling free queues behave like default free queues, but pending items
+* can be handed back with eina_freeq_ptr_take() instead of being freed and
+* allocated again. Only items added with the libc free() function (a NULL
+* free function) and a non-zero size can be recycled. Items are grouped by
+* size class, and only become available once they have spent the
+* quarantine set with eina_freeq_recycle_quarantine_set() in the queue.
+*
+* As this type of free queue is thread-safe, the free functions used must
+* also be thread-safe (e.g.. libc free()).
+*
+* @since 1.21
+*/
+
+EINA_FREEQ_RECYCLE,
+
+/** @brief Epoch based free queue.
+*
+* Epoch based free queues defer the freeing of objects that may still be
+* read by other threads. Readers surround every access to the shared data
+* with eina_freeq_epoch_enter() and eina_freeq_epoch_leave(), while writers
+* unlink objects from the shared data and then add them with
+* eina_freeq_ptr_add(). An object is only freed once every thread that was
+* inside a read section when it was added has left it.
+*
+* This allows readers to walk shared structures without taking any lock.
+* Count and memory limits are honored on a best effort basis, since objects
+* still visible to a reader can not be freed to make room.
+*
+* Items added to this type of free queue are never freed immediately:
+* EINA_FREEQ_BYPASS, running under valgrind and a count or memory
+* limit of 0 do not apply to it. Limits never force the eviction of an
+* item that may still be read.
+*
+* eina_freeq_epoch_synchronize() only frees the items that were pending
+* when it was called, once the readers present at that time have left.
+* Items retired while it waits are kept for the next grace period.
+*
+* eina_freeq_free() on this type of free queue waits, like
+* eina_freeq_epoch_synchronize(), until no thread is inside a read section
+* before freeing the pending items and the queue. It must thus not be
+* called from within a read section, and once it has been called, no
+* thread may enter a read section on the queue nor add items to it. This
+* is what makes freeing all the pending items safe.
+*
+* This type of free queue is thread-safe, and free functions used must
+* also be thread-safe (e.g.. libc free()).
+*
+* @since 1.21
+*/
+
+EINA_FREEQ_EPOCH,
 } Eina_FreeQ_Type;
 
+/**
+ * @def EINA_FREEQ_STATS_LATENCY_BUCKETS
+ * @brief The number of buckets in the flush latency histogram.
+ *
+ * Bucket 0 counts flushes that took less than 1 microsecond, and bucket N
+ * counts flushes that took between 2^(N-1) and 2^N microseconds. The last
+ * bucket also counts all the flushes that took longer.
+ *
+ * @since 1.21
+ */
+#define EINA_FREEQ_STATS_LATENCY_BUCKETS 24
+
+/**
+ * @typedef Eina_FreeQ_Stats
+ * @brief Type for #_Eina_FreeQ_Stats.
+ * @since 1.21
+ */
+typedef struct _Eina_FreeQ_Stats Eina_FreeQ_Stats;
+
+/**
+ * @struct _Eina_FreeQ_Stats
+ * @brief The structure to store the statistics of a free queue.
+ *
+ * Counters are accumulated since the queue was created, or since the last
+ * call to eina_freeq_stats_reset().
+ *
+ * @since 1.21
+ */
+struct _Eina_FreeQ_Stats
+{
+   size_t             count;          /**< The number of items currently pending */
+   size_t             count_peak;     /**< The highest number of items pending at once */
+   size_t             mem;            /**< The number of bytes currently pending */
+   size_t             mem_peak;       /**< The highest number of bytes pending at once */
+   unsigned long long adds;           /**< The number of items added */
+   unsigned long long frees;          /**< The number of items freed */
+   unsigned long long evict_count;    /**< The number of items freed to honor the count limit */
+   unsigned long long evict_mem;      /**< The number of items freed to honor the memory limit */
+   unsigned long long flushes;        /**< The number of clear, reduce and eviction runs */
+   unsigned long long flush_latency[EINA_FREEQ_STATS_LATENCY_BUCKETS]; /**< Histogram of the duration of each flush, see #EINA_FREEQ_STATS_LATENCY_BUCKETS */
+};
+
 /**
  * @brief Create a new free queue to defer freeing of data.
  * @return A new free queue.
@@ -151,6 +253,12 @@ eina_freeq_new(Eina_FreeQ_Type type);
 /**
  * @brief Free a free queue and anything that is queued within it.
  * @param[in,out] fq The free queue to free and clear.
+ *
+ * @note On a free queue of type #EINA_FREEQ_EPOCH, this waits until no
+ * thread is inside a read section. It must not be called from within one,
+ * and no thread may enter a read section or add items once it has been
+ * called, since all the pending items are then freed.
+ *
  * @since 1.19
  */
 EAPI void
@@ -232,12 +340,128 @@ eina_freeq_mem_max_set(Eina_FreeQ *fq, size_t mem);
 EAPI size_t
 eina_freeq_mem_max_get(Eina_FreeQ *fq);
 
+/**
+ * @brief Set the size of the per-thread front cache of a free queue.
+ * @param[in,out] fq The free queue to alter.
+ * @param[in] count The maximum number of items each thread may buffer
+ *            before handing them over to the queue. A value of 0 or less
+ *            disables the cache.
+ *
+ * When the cache is enabled, every thread calling eina_freeq_ptr_add() on
+ * @p fq gets its own small buffer of pending items. Items are added to this
+ * buffer without taking the queue lock, and are moved into the shared queue
+ * in a single batch once the buffer is full. This removes lock contention
+ * when many threads feed the same queue, like the main free queue.
+ *
+ * Limits set with eina_freeq_count_max_set() and eina_freeq_mem_max_set()
+ * are only checked when a batch is moved into the shared queue. They may
+ * thus be exceeded by up to @p count items per thread.
+ *
+ * A thread never writes into a buffer it does not own. Each thread holds
+ * its buffer through a pointer that it atomically exchanges with NULL at
+ * the start of an add, and puts back at the end. To hand a buffer over,
+ * another thread atomically exchanges the same pointer with NULL and
+ * moves the buffer it got into the shared queue. If it gets NULL, the
+ * owner is in the middle of an add: a handover request is then left on
+ * the buffer slot, and the owner moves its buffer into the shared queue
+ * itself at the end of that add, instead of putting it back.
+ *
+ * Disabling the cache and eina_freeq_clear() hand over the buffers of all
+ * the threads this way, so they see every buffered item except those of
+ * adds running at the same time, which are handed over when these adds
+ * complete. eina_freeq_free() must not race with adds, so it always sees
+ * every buffered item.
+ *
+ * eina_freeq_ptr_pending() also returns EINA_TRUE when only a thread
+ * cache holds items. eina_freeq_reduce() only frees items already in the
+ * shared queue, it never takes items out of the thread caches.
+ *
+ * @note Only free queues of type #EINA_FREEQ_DEFAULT support a thread
+ *       cache. Setting it on a queue of type #EINA_FREEQ_POSTPONED,
+ *       #EINA_FREEQ_RECYCLE or #EINA_FREEQ_EPOCH has no effect, since
+ *       buffered items could neither be taken back nor be tied to the
+ *       epoch they were retired in.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_thread_cache_set(Eina_FreeQ *fq, int count);
+
+/**
+ * @brief Get the size of the per-thread front cache of a free queue.
+ * @param[in] fq The free queue to query.
+ * @return The maximum number of items each thread may buffer, or 0 if
+ *         the cache is disabled.
+ *
+ * @since 1.21
+ */
+EAPI int
+eina_freeq_thread_cache_get(Eina_FreeQ *fq);
+
+/**
+ * @brief Move the items buffered by the calling thread into the queue.
+ * @param[in,out] fq The free queue to flush the thread cache of.
+ *
+ * The cache of a thread is reclaimed, and its items moved into the
+ * queue, when the thread exits, or when the queue hands over all the
+ * buffers as described in eina_freeq_thread_cache_set(). Threads that
+ * stop adding to a queue for a long time without exiting, like idle
+ * workers of a thread pool, should call this so their buffered items are
+ * not held back until then.
+ *
+ * @see eina_freeq_thread_cache_set()
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_thread_cache_flush(Eina_FreeQ *fq);
+
+/**
+ * @brief Move the freeing of excess items out of the adding thread.
+ * @param[in,out] fq The free queue to alter.
+ * @param[in] budget_us The maximum time, in microseconds, a single call to
+ *            eina_freeq_ptr_add() may spend freeing items. A value of 0
+ *            disables the reclaimer.
+ *
+ * By default, when an item added to a bounded queue makes it go over the
+ * limits set with eina_freeq_count_max_set() or eina_freeq_mem_max_set(),
+ * the excess items are freed right away by the thread adding the item.
+ *
+ * With the reclaimer enabled, eina_freeq_ptr_add() frees items for at most
+ * @p budget_us and leaves the rest of the excess to a low priority
+ * reclaimer thread shared by all the queues. Limits may thus be exceeded
+ * for a short time, until the reclaimer catches up.
+ *
+ * For queues of type #EINA_FREEQ_POSTPONED, the reclaimer never runs on
+ * another thread. Instead, when the execution comes back to the loop,
+ * the queue is flushed in chunks of at most @p budget_us, and the rest is
+ * kept for the next loop iteration.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_reclaimer_set(Eina_FreeQ *fq, unsigned int budget_us);
+
+/**
+ * @brief Get the time budget of the reclaimer of a free queue.
+ * @param[in] fq The free queue to query.
+ * @return The time budget in microseconds, or 0 if the reclaimer is disabled.
+ *
+ * @since 1.21
+ */
+EAPI unsigned int
+eina_freeq_reclaimer_get(Eina_FreeQ *fq);
+
 /**
  * @brief Clear out all queued items to be freed by freeing them.
  * @param[in,out] fq The free queue to clear.
  *
  * Removes all queued items from the free queue.
  * When it returns, the free queue should be empty.
+ *
+ * @note On a free queue of type #EINA_FREEQ_EPOCH, items that may still
+ *       be read by another thread are kept. Use
+ *       eina_freeq_epoch_synchronize() to wait for them.
  * 
  * @since 1.19
  */
@@ -269,6 +493,36 @@ eina_freeq_reduce(Eina_FreeQ *fq, int count);
 EAPI Eina_Bool
 eina_freeq_ptr_pending(Eina_FreeQ *fq);
 
+/**
+ * @brief Get the statistics of a free queue.
+ * @param[in] fq The free queue to query.
+ * @param[out] stats The structure to fill with the statistics.
+ * @return EINA_TRUE if @p stats was filled. Otherwise, EINA_FALSE.
+ *
+ * Counters are kept per thread and are only summed when this function is
+ * called, so keeping track of them costs very little on the hot path. As
+ * the counters of other threads are read without stopping them,
+ * the result is a close approximation on a busy queue.
+ *
+ * Use the peak values to choose the limits passed to
+ * eina_freeq_count_max_set() and eina_freeq_mem_max_set().
+ *
+ * @since 1.21
+ */
+EAPI Eina_Bool
+eina_freeq_stats_get(Eina_FreeQ *fq, Eina_FreeQ_Stats *stats);
+
+/**
+ * @brief Reset the statistics of a free queue.
+ * @param[in,out] fq The free queue to reset the statistics of.
+ *
+ * Resets all the counters, and sets the peak values to the current ones.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_stats_reset(Eina_FreeQ *fq);
+
 /**
  * @brief Add a pointer with a free function and the size to the free queue.
  * @param[in,out] fq The free queue to add the pointer to.
@@ -299,6 +553,10 @@ eina_freeq_ptr_pending(Eina_FreeQ *fq);
  * @note When using tools like valgrind, eina will immediately free
  * the data so valgrind's own memory checkers can be deployed.
  *
+ * @note On a free queue of type #EINA_FREEQ_EPOCH, items are never freed
+ * immediately, neither under valgrind, nor with EINA_FREEQ_BYPASS=1, nor
+ * because of a count or memory limit, as readers may still access them.
+ *
  * @note The free function must not be used to access the content of the 
  * memory to be freed and consider it to be invalid or to be full of garbage.
  * It is already invalid at the moment it is added to the free queue. Only
@@ -318,6 +576,135 @@ eina_freeq_ptr_pending(Eina_FreeQ *fq);
 EAPI void
 eina_freeq_ptr_add(Eina_FreeQ *fq, void *ptr, void (*free_func) (void *ptr), size_t size);
 
+/**
+ * @brief Add a pointer that may be freed together with others of its kind.
+ * @param[in,out] fq The free queue to add the pointer to.
+ * @param[in] ptr The pointer to free.
+ * @param[in] free_func The function used to free a single pointer.
+ * @param[in] free_batch The function used to free many pointers at once.
+ * @param[in] size The size of the data the pointer points to.
+ *
+ * This is the same as eina_freeq_ptr_add(), but when the queue is flushed
+ * by eina_freeq_clear(), eina_freeq_reduce() or because a limit was hit,
+ * consecutive pending items sharing the same @p free_func and @p free_batch
+ * are grouped and handed to @p free_batch in a single call. Each call
+ * receives an array of @p n pointers in the order they were added. The
+ * array is only valid for the duration of the call.
+ *
+ * If @p free_batch is NULL, this behaves exactly like eina_freeq_ptr_add().
+ * @p free_func is still used whenever an item has to be freed on its own,
+ * for example when the queue is bypassed.
+ *
+ * The same rules as for @p free_func apply to @p free_batch: it must not
+ * access the content of the memory it frees, and it must be thread-safe
+ * when used on a queue of type #EINA_FREEQ_DEFAULT.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_ptr_add_batchable(Eina_FreeQ *fq, void *ptr, void (*free_func) (void *ptr), void (*free_batch) (void **ptrs, size_t n), size_t size);
+
+/**
+ * @brief Take back a pending block of memory from a recycling free queue.
+ * @param[in,out] fq The free queue to take the block from.
+ * @param[in] size The number of bytes needed.
+ * @return A block of at least @p size bytes, or NULL if none is available.
+ *
+ * Looks for a pending item of the size class of @p size which has spent
+ * its quarantine in @p fq, removes it from the queue and returns it. The
+ * returned block belongs to the caller again, as if it was returned by
+ * malloc(), and must eventually be released with free() or added
+ * back to a free queue. Its content is undefined and may be filled with
+ * the debugging pattern set by EINA_FREEQ_FILL.
+ *
+ * On a NULL return, the caller is expected to fall back to malloc().
+ *
+ * @note This only works on free queues of type #EINA_FREEQ_RECYCLE. Other
+ *       types of free queue always return NULL.
+ *
+ * @since 1.21
+ */
+EAPI void *
+eina_freeq_ptr_take(Eina_FreeQ *fq, size_t size);
+
+/**
+ * @brief Set the quarantine of items in a recycling free queue.
+ * @param[in,out] fq The free queue to alter.
+ * @param[in] count The number of items that must be added after an item
+ *            before it can be taken back with eina_freeq_ptr_take().
+ *
+ * Memory added to a free queue may still be accessed by badly written code
+ * for a short while. The quarantine ensures the memory is not reused before
+ * enough other items have gone through the queue. A @p count of 0 allows
+ * items to be recycled right away.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_recycle_quarantine_set(Eina_FreeQ *fq, unsigned int count);
+
+/**
+ * @brief Get the quarantine of items in a recycling free queue.
+ * @param[in] fq The free queue to query.
+ * @return The number of items that must be added after an item before it
+ *         can be recycled.
+ *
+ * @since 1.21
+ */
+EAPI unsigned int
+eina_freeq_recycle_quarantine_get(Eina_FreeQ *fq);
+
+/**
+ * @brief Enter a read section on an epoch based free queue.
+ * @param[in,out] fq The free queue protecting the data about to be read.
+ *
+ * Until the matching eina_freeq_epoch_leave(), no object added to @p fq
+ * from now on will be freed, so the calling thread may safely access any
+ * object it can still reach. Read sections may be nested, in which case
+ * only the outermost one matters.
+ *
+ * Entering and leaving a read section never blocks and does not take
+ * any lock.
+ *
+ * @note Read sections should be kept short, as no object retired while a
+ *       thread is inside one can be freed.
+ *
+ * @note This only works on free queues of type #EINA_FREEQ_EPOCH.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_epoch_enter(Eina_FreeQ *fq);
+
+/**
+ * @brief Leave a read section on an epoch based free queue.
+ * @param[in,out] fq The free queue passed to eina_freeq_epoch_enter().
+ *
+ * After this call, the calling thread must not access any object it
+ * reached during the read section.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_epoch_leave(Eina_FreeQ *fq);
+
+/**
+ * @brief Wait until the objects pending in an epoch queue can be freed.
+ * @param[in,out] fq The free queue to synchronize.
+ *
+ * Blocks until every thread that was in a read section on @p fq when this
+ * function was called has left it, and then frees every item that was
+ * pending when this function was called. Items added while it waits may
+ * still be reached by readers that entered a read section after the call
+ * started, so they are kept for the next grace period.
+ *
+ * @warning Calling this from within a read section on @p fq deadlocks.
+ *
+ * @since 1.21
+ */
+EAPI void
+eina_freeq_epoch_synchronize(Eina_FreeQ *fq);
+
 /**
  * @brief Add a pointer to the main free queue.
  * @param[in] ptr The pointer to free.